@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+
+/*
+ * MemoryPool - Arena for book nodes, mmap'd up front (2 MB hugepages
+ * where available) and recycled through size-class free lists.
+ * Requests it cannot serve fall back to the global heap.
+ */
+class MemoryPool {
+public:
+    MemoryPool() = default;
+    ~MemoryPool();
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    bool Reserve(size_t bytes);
+    void Prefault();
+    bool Lock();
+
+    void* Allocate(size_t bytes);
+    void  Deallocate(void* ptr, size_t bytes);
+
+    size_t Capacity() const { return capacity; }
+    size_t Used() const { return used; }
+    size_t Overflows() const { return overflows; }
+    bool   Locked() const { return locked; }
+    const std::string& Backing() const { return backing; }
+
+private:
+    static constexpr size_t kAlign = 16;
+    static constexpr size_t kMaxSmall = 512;
+
+    struct FreeBlock { FreeBlock* next; };
+
+    char*  base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t overflows = 0;   // requests spilled to the heap once the arena was full
+    bool   locked = false;
+    std::string backing = "heap";
+
+    std::array<FreeBlock*, kMaxSmall / kAlign> freeLists{};
+
+    bool Owns(void* ptr) const {
+        char* p = static_cast<char*>(ptr);
+        return base != nullptr && p >= base && p < base + capacity;
+    }
+};
+
+/*
+ * PoolAllocator - Standard allocator over a MemoryPool, used for
+ * allocate_shared and the order index
+ */
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    MemoryPool* pool;
+
+    explicit PoolAllocator(MemoryPool* p) : pool(p) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : pool(other.pool) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(pool -> Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        pool -> Deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return pool == other.pool; }
+};
@@ -1,24 +1,50 @@
 #pragma once
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include "limit.h"
+#include "memory_pool.h"
 #include "order.h"
 
+using OrderIndex = std::unordered_map<int, std::shared_ptr<Order>,
+                                      std::hash<int>, std::equal_to<int>,
+                                      PoolAllocator<std::pair<const int, std::shared_ptr<Order>>>>;
+
 class Book {
 public:
+    // Synthetic warm-up flow shape (see WarmUp)
+    static constexpr int kWarmUpLevels = 8;
+    static constexpr int kWarmUpDepth = 2 * kWarmUpLevels;
+    static constexpr size_t kWarmUpMaxOrders = 2 * kWarmUpDepth + 2;
+
+    // Backs orders, levels and orderIndex; declared first so it outlives them
+    MemoryPool pool;
+
     std::shared_ptr<Limit> buyRoot = nullptr;
     std::shared_ptr<Limit> sellRoot = nullptr;
 
     std::weak_ptr<Limit> highestBuy;
     std::weak_ptr<Limit> lowestSell;
 
-    std::unordered_map<int, std::shared_ptr<Order>> orderIndex;
+    OrderIndex orderIndex{0, std::hash<int>(), std::equal_to<int>(),
+                          OrderIndex::allocator_type(&pool)};
+    size_t reservedBuckets = 0;
+
+    // Call auction: orders rest without matching until Uncross()
+    bool auctionMode = false;
+
+    // Matching/trade console output (off during warm-up)
+    bool logging = true;
 
 
     // Private helper functions
     std::shared_ptr<Limit> FindLimit(int price, Side side);
     std::shared_ptr<Limit> InsertLimit(int price, Side side);
     void RemoveLimit(std::shared_ptr<Limit> limit, Side side);
+    void CollectLevels(std::shared_ptr<Limit> node,
+                       std::vector<std::shared_ptr<Limit>>& levels);
 
 
     void AddOrder(int id, int shares, int price, Side side);
@@ -27,7 +53,13 @@ public:
     void MatchOrder(std::shared_ptr<Order> order);
     void ExecuteTrade(std::shared_ptr<Order> buyOrder, 
                       std::shared_ptr<Order> sellOrder, 
-                      int quantity);
+                      int quantity,
+                      int price);
+    void BeginAuction();
+    void Uncross();
+    bool Reserve(size_t maxOrders, size_t maxLevels);
+    bool WithinReservation() const;
+    void WarmUp(int messages, std::vector<uint64_t>* latencies = nullptr);
     void PrintBook();
     void PrintSide(std::shared_ptr<Limit> node);
 };
@@ -1,7 +1,13 @@
 #include "../include/order_book.h"
 #include <iostream>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 
 using namespace std;
 
@@ -51,6 +57,12 @@ void interactiveMode(Book& book) {
         else if (choice == 4) {
             book.PrintBook();
         }
+        else if (choice == 5) {
+            book.BeginAuction();
+        }
+        else if (choice == 6) {
+            book.Uncross();
+        }
     }
 }
 
@@ -101,6 +113,14 @@ void fileMode(Book& book, const string& filename) {
             cout << "\n[Line " << lineNum << "] Printing Book:" << endl;
             book.PrintBook();
         }
+        else if (action == 'C') {
+            cout << "\n[Line " << lineNum << "] Starting Call Auction" << endl;
+            book.BeginAuction();
+        }
+        else if (action == 'U') {
+            cout << "\n[Line " << lineNum << "] Uncrossing Auction" << endl;
+            book.Uncross();
+        }
         else {
             cout << "Warning: Unknown action '" << action << "' on line " << lineNum << endl;
         }
@@ -110,8 +130,94 @@ void fileMode(Book& book, const string& filename) {
     cout << "\nFile processing complete!\n";
 }
 
-int main() {
+void printLatency(const string& label, vector<uint64_t> samples) {
+    if (samples.empty()) return;
+    sort(samples.begin(), samples.end());
+
+    uint64_t total = 0;
+    for (uint64_t ns : samples) total += ns;
+
+    auto pct = [&](double p) { return samples[static_cast<size_t>(p * (samples.size() - 1))]; };
+
+    cout << "  " << left << setw(24) << label << right
+         << "  mean " << total / samples.size()
+         << "  p50 " << pct(0.50)
+         << "  p99 " << pct(0.99)
+         << "  p99.9 " << pct(0.999)
+         << "  max " << samples.back() << " ns" << endl;
+}
+
+void startupMode(Book& book, size_t maxOrders) {
+    const int probeMessages = 10000;
+    const int warmUpMessages = 200000;
+
+    cout << "=== Startup Warm-up ===\n";
+
+    // Cold process baseline: a throwaway book with no reservation
+    vector<uint64_t> scratchCold;
+    {
+        Book scratch;
+        scratch.WarmUp(probeMessages, &scratchCold);
+    }
+
+    if (book.Reserve(maxOrders, maxOrders / 8)) {
+        cout << "Memory: " << book.pool.Capacity() / (1024 * 1024) << " MB on "
+             << book.pool.Backing() << ", prefaulted, "
+             << (book.pool.Locked() ? "locked" : "mlock failed (check ulimit -l)") << endl;
+    }
+    else {
+        cout << "Memory: mmap failed, using heap (order index pre-sized)" << endl;
+    }
+
+    // The session book's own first messages, reserved but not yet warmed
+    vector<uint64_t> before;
+    book.WarmUp(probeMessages, &before);
+
+    book.WarmUp(warmUpMessages);
+
+    vector<uint64_t> warm;
+    book.WarmUp(probeMessages, &warm);
+
+    bool empty = book.orderIndex.empty() && !book.buyRoot && !book.sellRoot;
+    cout << "Warm-up: " << warmUpMessages << " messages, book "
+         << (empty ? "empty" : "NOT empty") << endl;
+
+    if (!book.WithinReservation()) {
+        cout << "Warning: book outgrew its reservation (index rehashed or arena spilled to heap)"
+             << endl;
+    }
+
+    cout << "First " << probeMessages << " messages:\n";
+    printLatency("cold scratch book", scratchCold);
+    printLatency("book before warm-up", before);
+    printLatency("book after warm-up", warm);
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
     Book book;
+
+    // --warmup [maxOrders]: reserve and warm the book before the session
+    if (argc > 1) {
+        const size_t minOrders = 1024;
+        size_t maxOrders = 100000;
+        bool valid = (string(argv[1]) == "--warmup" && argc <= 3);
+
+        if (valid && argc == 3) {
+            const char* arg = argv[2];
+            const char* end = arg + strlen(arg);
+            auto [ptr, ec] = from_chars(arg, end, maxOrders);
+            valid = (ec == errc() && ptr == end && maxOrders >= minOrders);
+        }
+
+        if (!valid) {
+            cout << "Usage: " << argv[0] << " [--warmup [maxOrders]]\n"
+                 << "  maxOrders: resting orders to reserve memory for (>= "
+                 << minOrders << ", default 100000)\n";
+            return 1;
+        }
+        startupMode(book, maxOrders);
+    }
     
     cout << "=== Order Book System ===\n";
     cout << "1 - Interactive Mode\n";
@@ -128,6 +234,8 @@ int main() {
         cout << "  2 - Remove Order\n";
         cout << "  3 - Modify Order\n";
         cout << "  4 - Print Book\n";
+        cout << "  5 - Start Call Auction\n";
+        cout << "  6 - Uncross Auction\n";
         cout << "  0 - Exit\n\n";
         
         interactiveMode(book);
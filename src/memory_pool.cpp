@@ -0,0 +1,107 @@
+#include "../include/memory_pool.h"
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+MemoryPool::~MemoryPool() {
+    if (base) {
+        if (locked) munlock(base, capacity);
+        munmap(base, capacity);
+    }
+}
+
+/*
+ * Reserve - Map the arena: explicit hugepages first, then regular pages
+ *           with a transparent hugepage hint
+ */
+bool MemoryPool::Reserve(size_t bytes) {
+    if (base) return false;
+
+    size_t size = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    void* mem = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem != MAP_FAILED) backing = "2MB hugepages (hugetlbfs)";
+#endif
+
+    if (mem == MAP_FAILED) {
+        mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) return false;
+
+        backing = "4KB pages";
+#ifdef MADV_HUGEPAGE
+        if (madvise(mem, size, MADV_HUGEPAGE) == 0) {
+            backing = "transparent hugepages (madvise)";
+        }
+#endif
+    }
+
+    base = static_cast<char*>(mem);
+    capacity = size;
+    used = 0;
+    return true;
+}
+
+/*
+ * Prefault - Touch every page so the hot path never takes a page fault
+ */
+void MemoryPool::Prefault() {
+    if (!base) return;
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < capacity; offset += pageSize) {
+        base[offset] = 0;
+    }
+}
+
+/*
+ * Lock - Pin the arena in RAM (needs RLIMIT_MEMLOCK headroom)
+ */
+bool MemoryPool::Lock() {
+    if (!base) return false;
+    if (!locked) locked = (mlock(base, capacity) == 0);
+    return locked;
+}
+
+void* MemoryPool::Allocate(size_t bytes) {
+    size_t rounded = (bytes + kAlign - 1) / kAlign * kAlign;
+
+    if (rounded <= kMaxSmall) {
+        FreeBlock*& head = freeLists[rounded / kAlign - 1];
+        if (head) {
+            FreeBlock* block = head;
+            head = block -> next;
+            return block;
+        }
+    }
+
+    if (base && used + rounded <= capacity) {
+        void* ptr = base + used;
+        used += rounded;
+        return ptr;
+    }
+
+    if (base) overflows++;
+    return ::operator new(bytes);
+}
+
+void MemoryPool::Deallocate(void* ptr, size_t bytes) {
+    if (!Owns(ptr)) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    // Large arena blocks (index buckets) are not recycled
+    size_t rounded = (bytes + kAlign - 1) / kAlign * kAlign;
+    if (rounded <= kMaxSmall) {
+        FreeBlock*& head = freeLists[rounded / kAlign - 1];
+        auto block = static_cast<FreeBlock*>(ptr);
+        block -> next = head;
+        head = block;
+    }
+}
@@ -1,6 +1,9 @@
 #include "../include/order_book.h"
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 
 //==============================================================================
 // TREE OPERATIONS
@@ -35,13 +38,14 @@ std::shared_ptr<Limit> Book::InsertLimit(int price, Side side) {
 
     std::shared_ptr<Limit>& root = (side == Side::BUY ? buyRoot : sellRoot);
 
-    auto newLimit = std::make_shared<Limit>();
+    auto newLimit = std::allocate_shared<Limit>(PoolAllocator<Limit>(&pool));
     newLimit -> limitPrice = price;
     newLimit -> size = 0;
     newLimit -> totalVolume = 0;
 
     if (root == nullptr) {
         root = newLimit;
+        (side == Side::BUY ? highestBuy : lowestSell) = newLimit;
         return newLimit;
     }
 
@@ -51,12 +55,12 @@ std::shared_ptr<Limit> Book::InsertLimit(int price, Side side) {
     while (current != nullptr) {
         if (current -> limitPrice > price) {
             parent = current;
-            current = current -> rightChild;
+            current = current -> leftChild;
         }
 
         else if (current -> limitPrice < price) {
             parent = current;
-            current = current -> leftChild;
+            current = current -> rightChild;
         }
 
         else {
@@ -108,6 +112,9 @@ void Book::RemoveLimit(std::shared_ptr<Limit> limit, Side side) {
             limit -> totalVolume = successor -> totalVolume;
             limit -> headOrder = successor -> headOrder;
             limit -> tailOrder = successor -> tailOrder;
+            for (auto o = limit -> headOrder; o; o = o -> nextOrder) {
+                o -> parentLimit = limit;
+            }
 
             RemoveLimit(successor, side);
             return;
@@ -179,6 +186,9 @@ void Book::RemoveLimit(std::shared_ptr<Limit> limit, Side side) {
         limit -> totalVolume = successor -> totalVolume;
         limit -> headOrder = successor -> headOrder;
         limit -> tailOrder = successor -> tailOrder;
+        for (auto o = limit -> headOrder; o; o = o -> nextOrder) {
+            o -> parentLimit = limit;
+        }
 
         RemoveLimit(successor, side);
         return;
@@ -210,6 +220,18 @@ void Book::RemoveLimit(std::shared_ptr<Limit> limit, Side side) {
     }
 }
 
+/*
+ * CollectLevels - Gather every price level of a tree (in-order)
+ */
+void Book::CollectLevels(std::shared_ptr<Limit> node,
+                         std::vector<std::shared_ptr<Limit>>& levels) {
+    if (!node) return;
+
+    CollectLevels(node -> leftChild, levels);
+    levels.push_back(node);
+    CollectLevels(node -> rightChild, levels);
+}
+
 //==============================================================================
 // ORDER OPERATIONS
 //==============================================================================
@@ -219,7 +241,7 @@ void Book::RemoveLimit(std::shared_ptr<Limit> limit, Side side) {
  */
 void Book::AddOrder(int id, int shares, int price, Side side) {
 
-    auto newOrder = std::make_shared<Order>();
+    auto newOrder = std::allocate_shared<Order>(PoolAllocator<Order>(&pool));
     newOrder -> id = id;
     newOrder -> shares = shares;
     newOrder -> price = price;
@@ -229,7 +251,10 @@ void Book::AddOrder(int id, int shares, int price, Side side) {
 
     orderIndex[id] = newOrder;
 
-    MatchOrder(newOrder);
+    // During a call auction orders rest crossed until Uncross()
+    if (!auctionMode) {
+        MatchOrder(newOrder);
+    }
 
     if (newOrder -> shares > 0) {
 
@@ -349,21 +374,21 @@ void Book::ModifyOrder(int orderId, int newShares, int newPrice) {
  */
 void Book::MatchOrder(std::shared_ptr<Order> order) {
 
-    std::cout << "\n>>> Matching Order #" << order->id << ": "
+    if (logging) std::cout << "\n>>> Matching Order #" << order->id << ": "
         << (order->side == Side::BUY ? "BUY" : "SELL") << " "
         << order->shares << " shares @ $" << order->price << std::endl;
 
 
     while (order -> shares > 0) {
-        std::cout << "  → Checking opposite side..." << std::endl;
+        if (logging) std::cout << "  → Checking opposite side..." << std::endl;
         auto oppositeLimit = (order->side == Side::BUY ? lowestSell.lock() : highestBuy.lock());
 
         if (!oppositeLimit || oppositeLimit->limitPrice == 0 || !oppositeLimit->headOrder) {
-            std::cout << "  → No opposite orders available" << std::endl;
+            if (logging) std::cout << "  → No opposite orders available" << std::endl;
             break;
         }
 
-        std::cout << "  → Found " << (order->side == Side::BUY ? "SELL" : "BUY")
+        if (logging) std::cout << "  → Found " << (order->side == Side::BUY ? "SELL" : "BUY")
             << " @ $" << oppositeLimit->limitPrice
             << " (" << oppositeLimit->totalVolume << " shares)" << std::endl;
 
@@ -371,17 +396,17 @@ void Book::MatchOrder(std::shared_ptr<Order> order) {
             if (order -> price >= oppositeLimit -> limitPrice) {
                 auto restingOrder = oppositeLimit -> headOrder;
                 int tradeQty = std::min(order -> shares, restingOrder -> shares);
-                std::cout << "  → Matching " << tradeQty << " shares..." << std::endl;
-                ExecuteTrade(order, restingOrder, tradeQty);
+                if (logging) std::cout << "  → Matching " << tradeQty << " shares..." << std::endl;
+                ExecuteTrade(order, restingOrder, tradeQty, oppositeLimit -> limitPrice);
                 if (order->shares > 0) {
-                    std::cout << "  → " << order->shares << " shares remaining" << std::endl;
+                    if (logging) std::cout << "  → " << order->shares << " shares remaining" << std::endl;
                 }
                 else {
-                    std::cout << "  → Order fully filled!" << std::endl;
+                    if (logging) std::cout << "  → Order fully filled!" << std::endl;
                 }
             }
             else {
-                std::cout << "  → Prices don't cross" << std::endl;
+                if (logging) std::cout << "  → Prices don't cross" << std::endl;
                 break;
             }        
         }
@@ -389,24 +414,24 @@ void Book::MatchOrder(std::shared_ptr<Order> order) {
             if (order -> price <= oppositeLimit -> limitPrice) {
                 auto restingOrder = oppositeLimit -> headOrder;
                 int tradeQty = std::min(order -> shares, restingOrder -> shares);
-                ExecuteTrade(restingOrder, order, tradeQty);
+                ExecuteTrade(restingOrder, order, tradeQty, oppositeLimit -> limitPrice);
                 if (order->shares > 0) {
-                    std::cout << "  → " << order->shares << " shares remaining" << std::endl;
+                    if (logging) std::cout << "  → " << order->shares << " shares remaining" << std::endl;
                 } else {
-                    std::cout << "  → Order fully filled! ✓" << std::endl;
+                    if (logging) std::cout << "  → Order fully filled! ✓" << std::endl;
                 }
             }
             else {
-                std::cout << "  → Prices don't cross" << std::endl;  // Add this
+                if (logging) std::cout << "  → Prices don't cross" << std::endl;  // Add this
                 break;
             }
         }
     }
 
     if (order->shares > 0) {
-        std::cout << "  → Adding " << order->shares << " shares to book\n" << std::endl;
+        if (logging) std::cout << "  → Adding " << order->shares << " shares to book\n" << std::endl;
     }
-    std::cout << std::endl;
+    if (logging) std::cout << std::endl;
 }
 
 /*
@@ -414,11 +439,14 @@ void Book::MatchOrder(std::shared_ptr<Order> order) {
  */
 void Book::ExecuteTrade(std::shared_ptr<Order> buyOrder, 
                         std::shared_ptr<Order> sellOrder, 
-                        int quantity) {
+                        int quantity,
+                        int price) {
     
-    std::cout << "TRADE: " << quantity << " shares @ $" << sellOrder -> price << std::endl;
-    std::cout << "  Buyer  : Order #" << buyOrder -> id << std::endl;
-    std::cout << "  Seller : Order #" << sellOrder -> id << std::endl;
+    if (logging) {
+        std::cout << "TRADE: " << quantity << " shares @ $" << price << std::endl;
+        std::cout << "  Buyer  : Order #" << buyOrder -> id << std::endl;
+        std::cout << "  Seller : Order #" << sellOrder -> id << std::endl;
+    }
 
     buyOrder -> shares -= quantity;
     sellOrder -> shares -= quantity;
@@ -433,6 +461,271 @@ void Book::ExecuteTrade(std::shared_ptr<Order> buyOrder,
     if (sellOrder -> shares == 0) RemoveOrder(sellOrder -> id);
 }
 
+//==============================================================================
+// CALL AUCTION
+//==============================================================================
+
+/*
+ * BeginAuction - Stop continuous matching; incoming orders rest crossed
+ */
+void Book::BeginAuction() {
+    auctionMode = true;
+    if (logging) std::cout << "\n>>> Call auction started (matching suspended)\n" << std::endl;
+}
+
+/*
+ * Uncross - Execute the auction at a single equilibrium price and
+ *           resume continuous matching
+ *
+ * The price maximises executable volume, then minimises the surplus.
+ * Remaining ties go to the highest price if the surplus is all on the
+ * buy side, the lowest if it is all on the sell side, otherwise to the
+ * middle of the tied range.
+ */
+void Book::Uncross() {
+    auctionMode = false;
+
+    std::vector<std::shared_ptr<Limit>> buyLevels;
+    std::vector<std::shared_ptr<Limit>> sellLevels;
+    CollectLevels(buyRoot, buyLevels);
+    CollectLevels(sellRoot, sellLevels);
+
+    // In-order walks are ascending; flip buys so each side is best price first
+    std::reverse(buyLevels.begin(), buyLevels.end());
+
+    if (logging) std::cout << "\n>>> Uncrossing auction book" << std::endl;
+
+    auto notCrossed = [&]() {
+        if (logging) std::cout << "  → Book not crossed, nothing to execute\n" << std::endl;
+        highestBuy = buyLevels.empty() ? std::weak_ptr<Limit>() : buyLevels.front();
+        lowestSell = sellLevels.empty() ? std::weak_ptr<Limit>() : sellLevels.front();
+    };
+
+    if (buyLevels.empty() || sellLevels.empty() ||
+        buyLevels.front() -> limitPrice < sellLevels.front() -> limitPrice) {
+        notCrossed();
+        return;
+    }
+
+    int bestBid = buyLevels.front() -> limitPrice;
+    int bestAsk = sellLevels.front() -> limitPrice;
+
+    // Candidate prices: every level inside the crossed range, ascending
+    std::vector<int> buyPrices;
+    std::vector<int> sellPrices;
+    for (auto it = buyLevels.rbegin(); it != buyLevels.rend(); ++it) {
+        if ((*it) -> limitPrice >= bestAsk) buyPrices.push_back((*it) -> limitPrice);
+    }
+    for (auto& level : sellLevels) {
+        if (level -> limitPrice > bestBid) break;
+        sellPrices.push_back(level -> limitPrice);
+    }
+
+    std::vector<int> prices;
+    prices.reserve(buyPrices.size() + sellPrices.size());
+    std::merge(buyPrices.begin(), buyPrices.end(), sellPrices.begin(), sellPrices.end(),
+               std::back_inserter(prices));
+    prices.erase(std::unique(prices.begin(), prices.end()), prices.end());
+
+    // Single ascending pass: demand only falls, supply only rises
+    int64_t demand = 0;
+    int64_t supply = 0;
+    for (auto& level : buyLevels) demand += level -> totalVolume;
+
+    size_t b = buyLevels.size();   // next buy level below the price (from the back)
+    size_t s = 0;                  // next sell level at or below the price
+
+    int64_t bestVolume = 0;
+    int64_t bestSurplus = 0;
+    std::vector<std::pair<int, int64_t>> tied;   // (price, signed surplus)
+
+    for (int price : prices) {
+        while (b > 0 && buyLevels[b - 1] -> limitPrice < price) {
+            demand -= buyLevels[--b] -> totalVolume;
+        }
+        while (s < sellLevels.size() && sellLevels[s] -> limitPrice <= price) {
+            supply += sellLevels[s++] -> totalVolume;
+        }
+
+        int64_t volume = std::min(demand, supply);
+        int64_t surplus = demand - supply;
+        int64_t absSurplus = surplus < 0 ? -surplus : surplus;
+
+        if (volume > bestVolume || (volume == bestVolume && absSurplus < bestSurplus)) {
+            bestVolume = volume;
+            bestSurplus = absSurplus;
+            tied.clear();
+        }
+        if (volume == bestVolume && absSurplus == bestSurplus) {
+            tied.emplace_back(price, surplus);
+        }
+    }
+
+    // Prices can overlap with nothing executable (e.g. orders modified to 0 shares)
+    if (bestVolume == 0) {
+        notCrossed();
+        return;
+    }
+
+    bool buyPressure = std::all_of(tied.begin(), tied.end(),
+                                   [](const auto& t) { return t.second > 0; });
+    bool sellPressure = std::all_of(tied.begin(), tied.end(),
+                                    [](const auto& t) { return t.second < 0; });
+
+    int auctionPrice;
+    if (buyPressure)       auctionPrice = tied.back().first;
+    else if (sellPressure) auctionPrice = tied.front().first;
+    else                   auctionPrice = tied[(tied.size() - 1) / 2].first;
+
+    if (logging) std::cout << "  → Equilibrium price $" << auctionPrice
+              << " (" << bestVolume << " shares, surplus " << bestSurplus << ")" << std::endl;
+
+    // Snapshot eligible orders in price-time priority before the book mutates
+    std::vector<std::shared_ptr<Order>> buys;
+    std::vector<std::shared_ptr<Order>> sells;
+    for (auto& level : buyLevels) {
+        if (level -> limitPrice < auctionPrice) break;
+        for (auto o = level -> headOrder; o; o = o -> nextOrder) buys.push_back(o);
+    }
+    for (auto& level : sellLevels) {
+        if (level -> limitPrice > auctionPrice) break;
+        for (auto o = level -> headOrder; o; o = o -> nextOrder) sells.push_back(o);
+    }
+
+    int64_t remaining = bestVolume;
+    size_t i = 0;
+    size_t j = 0;
+    while (remaining > 0 && i < buys.size() && j < sells.size()) {
+        int tradeQty = std::min(buys[i] -> shares, sells[j] -> shares);
+        if (tradeQty > remaining) tradeQty = static_cast<int>(remaining);
+
+        ExecuteTrade(buys[i], sells[j], tradeQty, auctionPrice);
+        remaining -= tradeQty;
+
+        if (buys[i] -> shares == 0) i++;
+        if (sells[j] -> shares == 0) j++;
+    }
+
+    // highestBuy/lowestSell stay current: RemoveLimit updates them as levels empty
+
+    if (logging) std::cout << "  → Auction complete, continuous matching resumed\n" << std::endl;
+}
+
+//==============================================================================
+// STARTUP
+//==============================================================================
+
+/*
+ * Reserve - Map, prefault and lock all book memory before trading
+ *
+ * Sizes the arena for maxOrders resting orders (node + index entry) and
+ * maxLevels price levels, and pre-sizes orderIndex so it never rehashes
+ * (on the heap if mapping fails). Must run on an empty book. Returns
+ * whether the arena was mapped; pool.Locked() tells if mlock succeeded.
+ */
+bool Book::Reserve(size_t maxOrders, size_t maxLevels) {
+    // allocate_shared control block and hash node overheads, rounded up
+    const size_t orderBytes = sizeof(Order) + 64;
+    const size_t levelBytes = sizeof(Limit) + 64;
+    const size_t indexBytes = sizeof(OrderIndex::value_type) + 32 + 2 * sizeof(void*);
+
+    size_t bytes = maxOrders * (orderBytes + indexBytes) + maxLevels * levelBytes;
+    bytes += bytes / 4;
+
+    bool mapped = pool.Reserve(bytes);
+
+    orderIndex.reserve(maxOrders);
+    reservedBuckets = orderIndex.bucket_count();
+
+    if (mapped) {
+        pool.Prefault();
+        pool.Lock();
+    }
+    return mapped;
+}
+
+/*
+ * WithinReservation - True if orderIndex has not rehashed and the arena
+ *                     has not spilled to the heap since Reserve()
+ */
+bool Book::WithinReservation() const {
+    return orderIndex.bucket_count() == reservedBuckets
+        && pool.Overflows() == 0;
+}
+
+/*
+ * WarmUp - Drive synthetic flow through AddOrder/MatchOrder/RemoveOrder
+ *          to warm caches, branch predictors and the arena free lists
+ *
+ * Seeds a standing book, then cycles bid/ask/aggressor/cancel. Each
+ * aggressor fills exactly one resting order and each cancel removes the
+ * other order added that cycle, so at most kWarmUpMaxOrders are live.
+ * Uses negative order IDs and cancels everything it left behind, so the
+ * book is empty afterwards. If latencies is given, records each
+ * message's latency in nanoseconds.
+ */
+void Book::WarmUp(int messages, std::vector<uint64_t>* latencies) {
+    const int midPrice = 10000;
+    const int spreadLevels = kWarmUpLevels;
+    const int seedMessages = 2 * kWarmUpDepth;
+
+    bool wasLogging = logging;
+    logging = false;
+
+    if (latencies) latencies -> reserve(latencies -> size() + messages);
+
+    for (int i = 0; i < messages; i++) {
+        int id = -(i + 1);
+
+        auto start = std::chrono::steady_clock::now();
+
+        if (i < seedMessages) {
+            // standing book: kWarmUpDepth orders per side across the levels
+            int offset = 1 + (i / 2) % spreadLevels;
+            if (i % 2 == 0) AddOrder(id, 100, midPrice - offset, Side::BUY);
+            else            AddOrder(id, 100, midPrice + offset, Side::SELL);
+        }
+        else {
+            int step = i - seedMessages;
+            int offset = 1 + (step / 4) % spreadLevels;
+            bool buyCycle = (step / 4) % 2 == 0;
+
+            switch (step % 4) {
+                case 0:  // resting bid
+                    AddOrder(id, 100, midPrice - offset, Side::BUY);
+                    break;
+                case 1:  // resting ask
+                    AddOrder(id, 100, midPrice + offset, Side::SELL);
+                    break;
+                case 2:  // aggressor filling the best opposite order
+                    if (buyCycle) AddOrder(id, 100, midPrice + spreadLevels, Side::BUY);
+                    else          AddOrder(id, 100, midPrice - spreadLevels, Side::SELL);
+                    break;
+                default: // cancel this cycle's order on the aggressor's side
+                    if (buyCycle) RemoveOrder(id + 3);
+                    else          RemoveOrder(id + 2);
+                    break;
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        if (latencies) {
+            latencies -> push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+    }
+
+    std::vector<int> leftovers;
+    for (auto& entry : orderIndex) {
+        if (entry.first < 0) leftovers.push_back(entry.first);
+    }
+    for (int id : leftovers) {
+        RemoveOrder(id);
+    }
+
+    logging = wasLogging;
+}
+
 //==============================================================================
 // UTILITY FUNCTIONS
 //==============================================================================